@@ -0,0 +1,133 @@
+#ifndef MATH_CHANNELS_H
+#define MATH_CHANNELS_H
+
+#include <stdint.h>
+
+#if defined(__ARM_FEATURE_SIMD32)
+#include <arm_acle.h>
+#endif
+
+// Math channel kernels for the oscilloscope.
+// Buffers hold signed 16-bit samples, must be 4-byte aligned and have an even length,
+// so the kernels can work on two samples packed in each 32-bit word.
+// No Arduino dependencies, so this header also builds on the host: see test/test_math_channels.
+
+enum MathMode {
+    MATH_OFF,
+    MATH_SUM,      // CH1 + CH2
+    MATH_DIFF,     // CH1 - CH2
+    MATH_PRODUCT,  // CH1 * CH2, scaled back to ADC counts
+    MATH_XY,       // CH1 on X, CH2 on Y
+    MATH_MODE_COUNT
+};
+
+#define MATH_PRODUCT_SHIFT 10  // Inputs are 10-bit, so >> 10 keeps the product in ADC counts
+
+// Lets a 16-bit sample buffer be read as 32-bit words without breaking aliasing rules
+typedef uint32_t __attribute__((__may_alias__)) packed16x2_t;
+
+// Saturating add of two 16-bit lanes
+inline uint32_t addSat16x2(uint32_t a, uint32_t b) {
+#if defined(__ARM_FEATURE_SIMD32)
+    return __qadd16(a, b);
+#else
+    // Add the low 15 bits of each lane, then fix up the sign bits so no carry crosses lanes
+    uint32_t sum = ((a & 0x7FFF7FFFu) + (b & 0x7FFF7FFFu)) ^ ((a ^ b) & 0x80008000u);
+    // A lane overflowed if both inputs had the same sign and the result did not
+    uint32_t overflow = ~(a ^ b) & (a ^ sum) & 0x80008000u;
+    uint32_t saturated = 0x7FFF7FFFu + ((a >> 15) & 0x00010001u);  // 0x7FFF or 0x8000 per lane
+    uint32_t mask = (overflow >> 15) * 0xFFFFu;
+    return (sum & ~mask) | (saturated & mask);
+#endif
+}
+
+// Saturating subtract of two 16-bit lanes
+inline uint32_t subSat16x2(uint32_t a, uint32_t b) {
+#if defined(__ARM_FEATURE_SIMD32)
+    return __qsub16(a, b);
+#else
+    // Set each lane's top bit before subtracting so no borrow crosses lanes, then fix it up
+    uint32_t diff = ((a | 0x80008000u) - (b & 0x7FFF7FFFu)) ^ ((a ^ ~b) & 0x80008000u);
+    // A lane overflowed if the inputs had different signs and the result changed sign
+    uint32_t overflow = (a ^ b) & (a ^ diff) & 0x80008000u;
+    uint32_t saturated = 0x7FFF7FFFu + ((a >> 15) & 0x00010001u);
+    uint32_t mask = (overflow >> 15) * 0xFFFFu;
+    return (diff & ~mask) | (saturated & mask);
+#endif
+}
+
+// Scaled, saturating product of one pair of samples
+inline int16_t mulSat16(int16_t a, int16_t b) {
+    int32_t product = ((int32_t)a * b) >> MATH_PRODUCT_SHIFT;
+    if (product > INT16_MAX) {
+        return INT16_MAX;
+    }
+    if (product < INT16_MIN) {
+        return INT16_MIN;
+    }
+    return (int16_t)product;
+}
+
+// Scaled, saturating product of two 16-bit lanes. There is no packed multiply on
+// the RP2040, so each lane is multiplied on its own and the results repacked.
+inline uint32_t mulSat16x2(uint32_t a, uint32_t b) {
+    uint16_t low = (uint16_t)mulSat16((int16_t)(a & 0xFFFFu), (int16_t)(b & 0xFFFFu));
+    uint16_t high = (uint16_t)mulSat16((int16_t)(a >> 16), (int16_t)(b >> 16));
+    return ((uint32_t)high << 16) | low;
+}
+
+// Compute the math channel for count samples (count must be even)
+inline void computeMathChannel(MathMode mode, const int16_t *ch1, const int16_t *ch2,
+                               int16_t *out, int count) {
+    const packed16x2_t *a = (const packed16x2_t *)ch1;
+    const packed16x2_t *b = (const packed16x2_t *)ch2;
+    packed16x2_t *result = (packed16x2_t *)out;
+    int words = count / 2;
+
+    switch (mode) {
+        case MATH_SUM:
+            for (int i = 0; i < words; i++) {
+                result[i] = addSat16x2(a[i], b[i]);
+            }
+            break;
+        case MATH_DIFF:
+            for (int i = 0; i < words; i++) {
+                result[i] = subSat16x2(a[i], b[i]);
+            }
+            break;
+        case MATH_PRODUCT:
+            for (int i = 0; i < words; i++) {
+                result[i] = mulSat16x2(a[i], b[i]);
+            }
+            break;
+        default:
+            // MATH_OFF and MATH_XY have no math trace
+            break;
+    }
+}
+
+// Single-sample version of computeMathChannel, used for readouts
+inline int mathSample(MathMode mode, int ch1, int ch2) {
+    int value;
+    switch (mode) {
+        case MATH_SUM:
+            value = ch1 + ch2;
+            break;
+        case MATH_DIFF:
+            value = ch1 - ch2;
+            break;
+        case MATH_PRODUCT:
+            return mulSat16((int16_t)ch1, (int16_t)ch2);
+        default:
+            return 0;
+    }
+    if (value > INT16_MAX) {
+        return INT16_MAX;
+    }
+    if (value < INT16_MIN) {
+        return INT16_MIN;
+    }
+    return value;
+}
+
+#endif // MATH_CHANNELS_H
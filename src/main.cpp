@@ -3,6 +3,7 @@
 #include <Adafruit_GFX.h>
 #include <Adafruit_SSD1306.h>
 #include <RotaryEncoder.h>
+#include "math_channels.h"
 //#include <EEPROM.h>
 
 // Display settings
@@ -10,6 +11,27 @@
 #define SCREEN_HEIGHT 64
 #define OLED_RESET -1
 #define SCREEN_ADDRESS 0x3C
+#define DISPLAY_RETRY_MIN 100        // First retry 100ms after a failed detection
+#define DISPLAY_RETRY_MAX 5000       // Back off to at most 5 seconds between retries
+#define DISPLAY_PROBE_INTERVAL 1000  // Check an attached display is still present every second
+#define DISPLAY_FRAME_INTERVAL 50    // Redraw the oscilloscope at most every 50ms
+#define HEADLESS_STREAM_INTERVAL 100 // Stream samples over serial every 100ms when headless
+
+// Graticule settings
+#define PIXELS_PER_DIV 16                            // Both axes use 16 pixel divisions
+#define TIME_DIVISIONS (SCREEN_WIDTH / PIXELS_PER_DIV) // 8 divisions across the screen
+#define TRACE_HEIGHT 48                              // Waveform area above the status line
+#define VOLTAGE_DIVISIONS (TRACE_HEIGHT / PIXELS_PER_DIV) // 3 divisions in the waveform area
+
+// Auto-set settings
+#define AUTOSET_BUTTON_PIN BUTTON1_PIN // Run Auto-set in oscilloscope mode
+#define AUTOSET_SAMPLES 256            // Samples per analysis capture
+#define AUTOSET_MIN_SWING 16           // Below this peak-to-peak (ADC counts) the input is treated as DC
+#define AUTOSET_PERIODS 3              // Aim for 3 periods on screen
+#define AUTOSET_MIN_SAMPLES_PER_PERIOD 4 // Faster signals alias at the fastest timebase
+
+// Math channel settings
+#define MATH_BUTTON_PIN BUTTON2_PIN    // Cycle math mode in oscilloscope mode
 
 // EEPROM settings
 #define EEPROM_SIZE 512
@@ -48,11 +70,20 @@ bool lastButtonState = HIGH;
 unsigned long lastDebounceTime = 0;
 const unsigned long debounceDelay = 50;
 unsigned long lastSampleTime = 0;
-const int SAMPLE_INTERVAL = 1000; // 1ms between samples
-#define BUFFER_SIZE 128
-int sampleBuffer[BUFFER_SIZE];
+#define BUFFER_SIZE (SCREEN_WIDTH * 2) // Room to find a trigger and still fill the screen after it
+// 16-bit and word aligned so the math kernels can process two samples per 32-bit word
+alignas(4) int16_t sampleBuffer[BUFFER_SIZE];
+alignas(4) int16_t sampleBuffer2[BUFFER_SIZE];
+alignas(4) int16_t mathBuffer[BUFFER_SIZE];
+unsigned long mathFrameMicros = 0;  // Time spent on the math channel for the last frame
 int bufferIndex = 0;
+int samplesSinceFrame = 0;        // Fresh samples captured since the last drawn frame
+int lastValue1 = 0;
+int lastValue2 = 0;
+bool firstSampleTaken = false;
+unsigned long bootToFirstSample = 0;  // micros() at the first sample, reported with the status output
 bool oscilloscopeActive = false;  // New flag to track if oscilloscope is running
+bool displayAttached = false;     // Set once the OLED answers on I2C and has been initialized
 
 // Scope settings
 struct ScopeSettings {
@@ -60,16 +91,22 @@ struct ScopeSettings {
     int voltageScale;   // Voltage per division
     int triggerLevel;   // Trigger level (0-1023)
     bool triggerEnabled;
+    bool triggerRising; // Trigger on rising (true) or falling (false) edge
+    int verticalCenter; // ADC value shown at the middle of the waveform area, set by Auto-set or the encoder
     bool showChannel2;  // Whether to show second channel
     int channel2Offset; // Vertical offset for channel 2
+    MathMode mathMode;  // Math channel shown with the inputs
     bool settingsPersistence; // Whether to save settings to EEPROM
 } scopeSettings = {
     .timeScale = 1,     // 1ms per division
-    .voltageScale = 100,// 100 units per division
+    .voltageScale = 350,// 350 units per division, full range on screen
     .triggerLevel = 512,// Middle of range
     .triggerEnabled = false,
+    .triggerRising = true,
+    .verticalCenter = 512,
     .showChannel2 = false,
     .channel2Offset = 20, // Pixels offset for channel 2
+    .mathMode = MATH_OFF,
     .settingsPersistence = true // Enable persistence by default
 };
 
@@ -82,6 +119,11 @@ void updateMainMenu();
 void updateOscilloscope();
 void updateSettings();
 void updateButtonTest();
+void acquireSamples();
+void serviceDisplay();
+void refreshDisplay();
+void streamSamples();
+void runAutoSet();
 
 // Function to save settings to EEPROM
 void saveSettings() {
@@ -142,47 +184,7 @@ void setup() {
    //     Serial.println(F("Using default settings"));
    // }
     
-    // Initialize I2C for Pico
-    Wire.begin();
-    Serial.println(F("I2C initialized"));
-    
-    // Give the display time to power up
-    delay(100);
-    Serial.println(F("Checking for display at address 0x3C..."));
-    
-    // Try to initialize the display
-    if(!display.begin(SSD1306_SWITCHCAPVCC, SCREEN_ADDRESS)) {
-        Serial.println(F("First display init failed, retrying..."));
-        // If display fails, try again with a delay
-        delay(100);
-        if(!display.begin(SSD1306_SWITCHCAPVCC, SCREEN_ADDRESS)) {
-            Serial.println(F("Second display init failed, entering retry loop..."));
-            // If still fails, keep trying with delays
-            for(;;) {
-                delay(100);
-                if(display.begin(SSD1306_SWITCHCAPVCC, SCREEN_ADDRESS)) {
-                    Serial.println(F("Display initialized in retry loop"));
-                    break;
-                }
-                Serial.println(F("Display init failed, retrying..."));
-            }
-        } else {
-            Serial.println(F("Display initialized on second attempt"));
-        }
-    } else {
-        Serial.println(F("Display initialized on first attempt"));
-    }
-    
-    // Additional display configuration
-    Serial.println(F("Configuring display..."));
-    display.clearDisplay();
-    display.setTextSize(1);
-    display.setTextColor(SSD1306_WHITE);
-    display.setRotation(0);
-    display.display();
-    Serial.println(F("Display configured"));
-    
-    // Initialize pins
+    // Initialize pins first so acquisition and input work without a display
     Serial.println(F("Initializing pins..."));
     pinMode(ENCODER_A_PIN, INPUT_PULLUP);
     pinMode(ENCODER_B_PIN, INPUT_PULLUP);
@@ -195,9 +197,12 @@ void setup() {
     pinMode(ANALOG_IN2, INPUT);
     Serial.println(F("Pins initialized"));
     
-    // Initial display
-    Serial.println(F("Displaying main menu..."));
-    displayMainMenu();
+    // Initialize I2C for Pico
+    // The display itself is detected and initialized from loop() by serviceDisplay(),
+    // so a missing or slow panel never holds up sampling or input.
+    Wire.begin();
+    Serial.println(F("I2C initialized"));
+    
     Serial.println(F("Setup complete"));
 }
 
@@ -205,6 +210,9 @@ void loop() {
     static MenuState lastState = MAIN_MENU;
     static unsigned long lastDebugTime = 0;
     
+    // Sample both channels before anything else
+    acquireSamples();
+    
     // Handle encoder
     encoder.tick();
     handleEncoderChange();
@@ -213,6 +221,10 @@ void loop() {
     // Check buttons
     checkButtons();
     
+    // Detect the display in the background, attach or detach the UI as needed
+    serviceDisplay();
+    streamSamples();
+    
     // Try to save settings if they've changed
     saveSettings();
     
@@ -233,6 +245,16 @@ void loop() {
                 Serial.println(F("BUTTON_TEST_MODE"));
                 break;
         }
+        if (firstSampleTaken) {
+            Serial.print(F("Boot to first sample: "));
+            Serial.print(bootToFirstSample);
+            Serial.println(F("us"));
+        }
+        if (scopeSettings.mathMode != MATH_OFF && scopeSettings.mathMode != MATH_XY) {
+            Serial.print(F("Math channel: "));
+            Serial.print(mathFrameMicros);
+            Serial.println(F("us per frame"));
+        }
         lastDebugTime = millis();
     }
     
@@ -296,7 +318,275 @@ void loop() {
     }
 }
 
+// Probe the display address on I2C without touching the panel itself
+bool probeDisplay() {
+    Wire.beginTransmission(SCREEN_ADDRESS);
+    return Wire.endTransmission() == 0;
+}
+
+void serviceDisplay() {
+    static unsigned long lastAttemptTime = 0;
+    static unsigned long retryInterval = 0;  // First attempt happens immediately
+    
+    if (!displayAttached) {
+        if (millis() - lastAttemptTime < retryInterval) {
+            return;
+        }
+        lastAttemptTime = millis();
+        
+        if (probeDisplay() && display.begin(SSD1306_SWITCHCAPVCC, SCREEN_ADDRESS)) {
+            Serial.println(F("Display found at address 0x3C, configuring..."));
+            display.clearDisplay();
+            display.setTextSize(1);
+            display.setTextColor(SSD1306_WHITE);
+            display.setRotation(0);
+            display.display();
+            displayAttached = true;
+            retryInterval = DISPLAY_RETRY_MIN;
+            Serial.println(F("Display attached"));
+            refreshDisplay();
+        } else {
+            // Back off exponentially so a missing panel costs almost nothing
+            retryInterval = retryInterval == 0 ? DISPLAY_RETRY_MIN
+                                               : min((unsigned long)DISPLAY_RETRY_MAX, retryInterval * 2);
+            Serial.print(F("Display not found, retrying in "));
+            Serial.print(retryInterval);
+            Serial.println(F("ms"));
+        }
+    } else {
+        // Make sure the display is still there
+        if (millis() - lastAttemptTime < DISPLAY_PROBE_INTERVAL) {
+            return;
+        }
+        lastAttemptTime = millis();
+        
+        if (!probeDisplay()) {
+            displayAttached = false;
+            retryInterval = DISPLAY_RETRY_MIN;
+            Serial.println(F("Display lost, running headless"));
+        }
+    }
+}
+
+// Redraw whatever the current state shows, used when the display (re)attaches
+void refreshDisplay() {
+    switch(currentState) {
+        case MAIN_MENU:
+            displayMainMenu();
+            break;
+        case OSCILLOSCOPE_MODE:
+            updateOscilloscope();
+            break;
+        case SETTINGS_MODE:
+            updateSettings();
+            break;
+        case BUTTON_TEST_MODE:
+            updateButtonTest();
+            break;
+    }
+}
+
+// Sample interval in microseconds so that one pixel column covers timeScale / PIXELS_PER_DIV
+unsigned long sampleInterval() {
+    return (unsigned long)scopeSettings.timeScale * 1000UL / PIXELS_PER_DIV;
+}
+
+void acquireSamples() {
+    unsigned long interval = sampleInterval();
+    unsigned long elapsed = micros() - lastSampleTime;
+    if (elapsed < interval) {
+        return;
+    }
+    
+    // Advance by exactly one interval so loop latency doesn't stretch the timebase,
+    // and only resync if we've fallen more than a whole interval behind
+    if (elapsed >= 2 * interval) {
+        lastSampleTime = micros();
+    } else {
+        lastSampleTime += interval;
+    }
+    
+    // Read the new values
+    int value1 = analogRead(ANALOG_IN);
+    int value2 = analogRead(ANALOG_IN2);
+    lastValue1 = value1;
+    lastValue2 = value2;
+    
+    // USB serial drops anything written before the host opens the port,
+    // so only record the boot time here and report it with the status output
+    if (!firstSampleTaken) {
+        bootToFirstSample = lastSampleTime;
+        firstSampleTaken = true;
+    }
+    
+    sampleBuffer[bufferIndex] = value1;
+    sampleBuffer2[bufferIndex] = value2;
+    bufferIndex = (bufferIndex + 1) % BUFFER_SIZE;
+    if (samplesSinceFrame < BUFFER_SIZE) {
+        samplesSinceFrame++;
+    }
+}
+
+// Capture AUTOSET_SAMPLES of channel 1 at the given interval and measure them.
+// Returns the number of rising crossings through the midpoint; firstCrossing and
+// lastCrossing are the sample indices of the first and last of them.
+int autoSetCapture(unsigned long interval, int &minValue, int &maxValue,
+                   int &firstCrossing, int &lastCrossing) {
+    static int capture[AUTOSET_SAMPLES];
+    
+    // Capture and track the amplitude range in the same pass
+    minValue = 1023;
+    maxValue = 0;
+    unsigned long sampleTime = micros();
+    for (int i = 0; i < AUTOSET_SAMPLES; i++) {
+        while (micros() - sampleTime < interval) {
+            // Wait for the next sample slot
+        }
+        sampleTime += interval;
+        int value = analogRead(ANALOG_IN);
+        capture[i] = value;
+        minValue = min(minValue, value);
+        maxValue = max(maxValue, value);
+    }
+    
+    // Count rising crossings with hysteresis so noise doesn't add extra edges
+    int midpoint = (minValue + maxValue) / 2;
+    int hysteresis = (maxValue - minValue) / 8;
+    bool armed = false;
+    int crossings = 0;
+    firstCrossing = 0;
+    lastCrossing = 0;
+    for (int i = 0; i < AUTOSET_SAMPLES; i++) {
+        if (capture[i] < midpoint - hysteresis) {
+            armed = true;
+        } else if (armed && capture[i] > midpoint + hysteresis) {
+            armed = false;
+            if (crossings == 0) {
+                firstCrossing = i;
+            }
+            lastCrossing = i;
+            crossings++;
+        }
+    }
+    return crossings;
+}
+
+// Pick timebase, vertical scale and trigger from a short capture of channel 1
+void runAutoSet() {
+    // Fastest rate first, slow down until at least two full periods fit in the capture.
+    // The slowest pass covers AUTOSET_SAMPLES ms, so the whole search stays under 300ms.
+    // A short fast pass can make a slow signal look flat, so the input is only treated
+    // as DC when the slowest pass finds no period; min/max come from the last pass run.
+    static const unsigned long intervals[] = {10, 100, 1000};
+    unsigned long startTime = micros();
+    int minValue = 0;
+    int maxValue = 0;
+    unsigned long periodMicros = 0;
+    
+    Serial.println(F("Auto-set started"));
+    for (unsigned int pass = 0; pass < sizeof(intervals) / sizeof(intervals[0]); pass++) {
+        int firstCrossing, lastCrossing;
+        int crossings = autoSetCapture(intervals[pass], minValue, maxValue, firstCrossing, lastCrossing);
+        
+        // Ignore crossings on a flat pass, they are only noise
+        if (maxValue - minValue >= AUTOSET_MIN_SWING && crossings >= 3) {
+            periodMicros = (unsigned long)(lastCrossing - firstCrossing) * intervals[pass] / (crossings - 1);
+            break;
+        }
+    }
+    
+    int swing = maxValue - minValue;
+    int dcLevel = (minValue + maxValue) / 2;
+    
+    // Center the signal and let it span all but one of the vertical divisions
+    scopeSettings.verticalCenter = dcLevel;
+    int voltageScale = ((swing / (VOLTAGE_DIVISIONS - 1)) + 49) / 50 * 50;
+    scopeSettings.voltageScale = max(50, min(500, voltageScale));
+    
+    if (periodMicros > 0) {
+        // Screen time is TIME_DIVISIONS * timeScale ms. Rounding to the nearest ms/div keeps
+        // 2-4 periods on screen; periods under 2ms are clamped to 1ms/div and show more.
+        unsigned long screenMicros = periodMicros * AUTOSET_PERIODS;
+        int timeScale = (screenMicros + TIME_DIVISIONS * 500UL) / (TIME_DIVISIONS * 1000UL);
+        scopeSettings.timeScale = max(1, min(100, timeScale));
+        scopeSettings.triggerLevel = dcLevel;
+        scopeSettings.triggerRising = true;
+        // Triggering on an aliased trace would only lock onto a false waveform
+        scopeSettings.triggerEnabled = periodMicros >= AUTOSET_MIN_SAMPLES_PER_PERIOD * sampleInterval();
+        if (!scopeSettings.triggerEnabled) {
+            Serial.println(F("Auto-set: signal too fast for the timebase, trigger off"));
+        }
+    } else {
+        // DC or too slow to measure, free run
+        scopeSettings.triggerEnabled = false;
+    }
+    
+    // Start a fresh capture with the new timebase
+    samplesSinceFrame = 0;
+    lastSampleTime = micros();
+    markSettingsChanged();
+    
+    Serial.print(F("Auto-set: min="));
+    Serial.print(minValue);
+    Serial.print(F(" max="));
+    Serial.print(maxValue);
+    Serial.print(F(" period="));
+    Serial.print(periodMicros);
+    Serial.print(F("us time="));
+    Serial.print(scopeSettings.timeScale);
+    Serial.print(F("ms/div volt="));
+    Serial.print(scopeSettings.voltageScale);
+    Serial.print(F("/div trig="));
+    Serial.print(scopeSettings.triggerEnabled ? scopeSettings.triggerLevel : -1);
+    Serial.print(F(" in "));
+    Serial.print(micros() - startTime);
+    Serial.println(F("us"));
+}
+
+// Short name of a math mode for the status line and serial output
+const __FlashStringHelper *mathLabel(MathMode mode) {
+    switch(mode) {
+        case MATH_SUM:
+            return F("A+B");
+        case MATH_DIFF:
+            return F("A-B");
+        case MATH_PRODUCT:
+            return F("AxB");
+        case MATH_XY:
+            return F("XY");
+        default:
+            return F("OFF");
+    }
+}
+
+// Without a display, stream the latest samples over serial instead
+void streamSamples() {
+    static unsigned long lastStreamTime = 0;
+    
+    if (displayAttached || millis() - lastStreamTime < HEADLESS_STREAM_INTERVAL) {
+        return;
+    }
+    lastStreamTime = millis();
+    
+    Serial.print(F("CH1:"));
+    Serial.print(lastValue1);
+    Serial.print(F(" CH2:"));
+    if (scopeSettings.mathMode == MATH_OFF || scopeSettings.mathMode == MATH_XY) {
+        Serial.println(lastValue2);
+    } else {
+        Serial.print(lastValue2);
+        Serial.print(F(" "));
+        Serial.print(mathLabel(scopeSettings.mathMode));
+        Serial.print(F(":"));
+        Serial.println(mathSample(scopeSettings.mathMode, lastValue1, lastValue2));
+    }
+}
+
 void displayMainMenu() {
+    if (!displayAttached) {
+        return;
+    }
+    
     Serial.println(F("Updating main menu display"));
     display.clearDisplay();
     display.setCursor(0, 0);
@@ -384,9 +674,16 @@ void handleEncoderChange() {
                     case 1: // Voltage scale
                         scopeSettings.voltageScale = max(50, min(500, scopeSettings.voltageScale + direction * 50));
                         break;
-                    case 2: // Trigger enable
-                        if (direction != 0) {  // Only toggle on actual movement
-                            scopeSettings.triggerEnabled = !scopeSettings.triggerEnabled;
+                    case 2: // Trigger mode, cycles OFF -> RISE -> FALL
+                        if (direction != 0) {  // Only change on actual movement
+                            if (!scopeSettings.triggerEnabled) {
+                                scopeSettings.triggerEnabled = true;
+                                scopeSettings.triggerRising = true;
+                            } else if (scopeSettings.triggerRising) {
+                                scopeSettings.triggerRising = false;
+                            } else {
+                                scopeSettings.triggerEnabled = false;
+                            }
                         }
                         break;
                     case 3: // Trigger level
@@ -415,9 +712,13 @@ void handleEncoderChange() {
                 break;
                 
             case OSCILLOSCOPE_MODE:
-                // Adjust channel 2 offset in oscilloscope mode
+                // Adjust channel 2 offset in oscilloscope mode, otherwise move the
+                // trace position (4 pixels per detent)
                 if (scopeSettings.showChannel2) {
                     scopeSettings.channel2Offset = max(0, min(40, scopeSettings.channel2Offset + direction));
+                } else {
+                    int step = scopeSettings.voltageScale * 4 / PIXELS_PER_DIV;
+                    scopeSettings.verticalCenter = max(0, min(1023, scopeSettings.verticalCenter - direction * step));
                 }
                 break;
                 
@@ -487,7 +788,8 @@ void handleEncoderButton() {
 }
 
 void checkButtons() {
-    static bool lastButtonState = HIGH;
+    static bool lastReading = false;      // Raw "any button down" reading from the last call
+    static bool buttonPressed = false;    // Debounced state
     static unsigned long lastDebounceTime = 0;
     const unsigned long debounceDelay = 50;  // Same as encoder button
     
@@ -496,71 +798,157 @@ void checkButtons() {
         return;
     }
     
-    bool currentButtonState = (digitalRead(BUTTON1_PIN) == LOW || 
-                             digitalRead(BUTTON2_PIN) == LOW || 
-                             digitalRead(BUTTON3_PIN) == LOW ||
-                             digitalRead(BUTTON4_PIN) == LOW);
+    bool reading = (digitalRead(BUTTON1_PIN) == LOW || 
+                    digitalRead(BUTTON2_PIN) == LOW || 
+                    digitalRead(BUTTON3_PIN) == LOW ||
+                    digitalRead(BUTTON4_PIN) == LOW);
     
-    // Check if the button state has changed
-    if (currentButtonState != lastButtonState) {
+    // Restart the debounce timer whenever the raw reading changes
+    if (reading != lastReading) {
         lastDebounceTime = millis();
     }
+    lastReading = reading;
     
-    // If the button state has been stable for the debounce period
-    if ((millis() - lastDebounceTime) > debounceDelay) {
-        if (currentButtonState == LOW && lastButtonState == HIGH) {  // Button just pressed
-            Serial.println(F("Back button pressed"));
-            if (currentState == OSCILLOSCOPE_MODE) {
-                oscilloscopeActive = false;
-            }
-            currentState = MAIN_MENU;
-            encoderValue = 0;
-            displayMainMenu();  // Update display when returning to menu
-        }
+    // Only act once the reading has been stable for the debounce period
+    if ((millis() - lastDebounceTime) <= debounceDelay || reading == buttonPressed) {
+        return;
     }
+    buttonPressed = reading;
     
-    lastButtonState = currentButtonState;
+    if (!buttonPressed) {
+        return;  // Released, nothing to do
+    }
+    
+    // Button just pressed, the pins have been steady for the debounce period
+    if (currentState == OSCILLOSCOPE_MODE && digitalRead(AUTOSET_BUTTON_PIN) == LOW) {
+        Serial.println(F("Auto-set button pressed"));
+        runAutoSet();
+    } else if (currentState == OSCILLOSCOPE_MODE && digitalRead(MATH_BUTTON_PIN) == LOW) {
+        scopeSettings.mathMode = (MathMode)((scopeSettings.mathMode + 1) % MATH_MODE_COUNT);
+        Serial.print(F("Math mode: "));
+        Serial.println(mathLabel(scopeSettings.mathMode));
+        markSettingsChanged();
+    } else {
+        Serial.println(F("Back button pressed"));
+        if (currentState == OSCILLOSCOPE_MODE) {
+            oscilloscopeActive = false;
+        }
+        currentState = MAIN_MENU;
+        encoderValue = 0;
+        displayMainMenu();  // Update display when returning to menu
+    }
 }
 
 void updateMainMenu() {
     // Menu is updated in displayMainMenu()
 }
 
+// Map a value to a screen row using the vertical scale, with center at mid-screen
+int traceY(int value, int center) {
+    long offset = (long)(value - center) * PIXELS_PER_DIV / scopeSettings.voltageScale;
+    return TRACE_HEIGHT / 2 - offset;
+}
+
+int traceY(int value) {
+    return traceY(value, scopeSettings.verticalCenter);
+}
+
+// Value of a math trace that corresponds to both inputs sitting at verticalCenter,
+// so A-B = 0 and A+B = 2 * center land mid-screen
+int mathCenter(MathMode mode) {
+    return mathSample(mode, scopeSettings.verticalCenter, scopeSettings.verticalCenter);
+}
+
+// Find where the frame should start in the capture buffer.
+// Returns an offset from the oldest sample, or -1 if the trigger edge was not found.
+int findTrigger(const int16_t *source, int level) {
+    if (!scopeSettings.triggerEnabled) {
+        return BUFFER_SIZE - SCREEN_WIDTH;  // Free run, show the newest samples
+    }
+    
+    for (int i = 1; i <= BUFFER_SIZE - SCREEN_WIDTH; i++) {
+        int previous = source[(bufferIndex + i - 1) % BUFFER_SIZE];
+        int current = source[(bufferIndex + i) % BUFFER_SIZE];
+        if (scopeSettings.triggerRising) {
+            if (previous < level && current >= level) {
+                return i;
+            }
+        } else {
+            if (previous > level && current <= level) {
+                return i;
+            }
+        }
+    }
+    return -1;
+}
+
 void updateOscilloscope() {
-    // Only process if oscilloscope is active
-    if (!oscilloscopeActive) {
+    static unsigned long lastFrameTime = 0;
+    
+    // Only draw if oscilloscope is active and there is a display to draw on
+    if (!oscilloscopeActive || !displayAttached) {
         return;
     }
 
-    if (millis() - lastSampleTime >= SAMPLE_INTERVAL) {
-        // Read and store the new values
-        int value1 = analogRead(ANALOG_IN);
-        int value2 = analogRead(ANALOG_IN2);
+    // Wait for a full buffer of new samples so every frame is one continuous capture
+    if (millis() - lastFrameTime >= DISPLAY_FRAME_INTERVAL && samplesSinceFrame >= BUFFER_SIZE) {
+        samplesSinceFrame = 0;
+        
+        MathMode mathMode = scopeSettings.mathMode;
+        bool showMath = mathMode != MATH_OFF && mathMode != MATH_XY;
+        
+        // The math channel is elementwise, so it can run over the whole ring in place
+        if (showMath) {
+            unsigned long mathStart = micros();
+            computeMathChannel(mathMode, sampleBuffer, sampleBuffer2, mathBuffer, BUFFER_SIZE);
+            mathFrameMicros = micros() - mathStart;
+        }
         
-        // Check trigger if enabled
-        if (scopeSettings.triggerEnabled) {
-            if (value1 < scopeSettings.triggerLevel) {
-                // Wait for trigger
-                return;
+        if (mathMode == MATH_XY) {
+            // CH1 across, CH2 up, no trigger needed. Both axes use the same counts per
+            // pixel so the figure isn't distorted, and stay clear of the status line.
+            display.clearDisplay();
+            for(int i = 0; i < BUFFER_SIZE; i++) {
+                long offset = (long)(sampleBuffer[i] - scopeSettings.verticalCenter) * PIXELS_PER_DIV / scopeSettings.voltageScale;
+                int x = max(0L, min((long)SCREEN_WIDTH - 1, SCREEN_WIDTH / 2 + offset));
+                int y = max(0, min(TRACE_HEIGHT - 1, traceY(sampleBuffer2[i])));
+                display.drawPixel(x, y, SSD1306_WHITE);
             }
+            display.setCursor(0, 56);
+            display.print(F("XY CH1:"));
+            display.print(lastValue1);
+            display.print(F(" CH2:"));
+            display.print(lastValue2);
+            display.display();
+            lastFrameTime = millis();
+            return;
         }
         
-        sampleBuffer[bufferIndex] = value1;
-        bufferIndex = (bufferIndex + 1) % BUFFER_SIZE;
+        // Trigger on the math channel when it is shown, with the level moved by the same
+        // amount as its center so the trigger stays at the same place on screen
+        int start;
+        if (showMath) {
+            int level = scopeSettings.triggerLevel - scopeSettings.verticalCenter + mathCenter(mathMode);
+            start = findTrigger(mathBuffer, level);
+        } else {
+            start = findTrigger(sampleBuffer, scopeSettings.triggerLevel);
+        }
+        if (start < 0) {
+            // Wait for trigger, keep the last frame on screen
+            return;
+        }
+        start += bufferIndex;
         
         display.clearDisplay();
-        display.setCursor(0, 0);
-        display.println(F("Oscilloscope"));
-        display.println(F("-------------"));
         
         // Draw the waveform for channel 1
-        for(int i = 0; i < BUFFER_SIZE - 1; i++) {
-            int currentIndex = (bufferIndex + i) % BUFFER_SIZE;
-            int nextIndex = (bufferIndex + i + 1) % BUFFER_SIZE;
+        for(int i = 0; i < SCREEN_WIDTH - 1; i++) {
+            int currentIndex = (start + i) % BUFFER_SIZE;
+            int nextIndex = (start + i + 1) % BUFFER_SIZE;
             
             // Map the values to screen coordinates
-            int y1 = map(sampleBuffer[currentIndex], 0, 1023, 48, 0);
-            int y2 = map(sampleBuffer[nextIndex], 0, 1023, 48, 0);
+            int y1 = traceY(sampleBuffer[currentIndex]);
+            int y2 = traceY(sampleBuffer[nextIndex]);
             
             // Draw a line between points
             display.drawLine(i, y1, i + 1, y2, SSD1306_WHITE);
@@ -568,42 +956,71 @@ void updateOscilloscope() {
         
         // Draw channel 2 if enabled
         if (scopeSettings.showChannel2) {
-            for(int i = 0; i < BUFFER_SIZE - 1; i++) {
-                int currentIndex = (bufferIndex + i) % BUFFER_SIZE;
-                int nextIndex = (bufferIndex + i + 1) % BUFFER_SIZE;
+            for(int i = 0; i < SCREEN_WIDTH - 1; i++) {
+                int currentIndex = (start + i) % BUFFER_SIZE;
+                int nextIndex = (start + i + 1) % BUFFER_SIZE;
                 
                 // Map the values to screen coordinates with offset
-                int y1 = map(value2, 0, 1023, 48, 0) + scopeSettings.channel2Offset;
-                int y2 = map(value2, 0, 1023, 48, 0) + scopeSettings.channel2Offset;
+                int y1 = traceY(sampleBuffer2[currentIndex]) + scopeSettings.channel2Offset;
+                int y2 = traceY(sampleBuffer2[nextIndex]) + scopeSettings.channel2Offset;
                 
                 // Draw a line between points
                 display.drawLine(i, y1, i + 1, y2, SSD1306_WHITE);
             }
         }
         
+        // Draw the math channel if enabled
+        if (showMath) {
+            int center = mathCenter(mathMode);
+            for(int i = 0; i < SCREEN_WIDTH - 1; i++) {
+                int currentIndex = (start + i) % BUFFER_SIZE;
+                int nextIndex = (start + i + 1) % BUFFER_SIZE;
+                
+                int y1 = traceY(mathBuffer[currentIndex], center);
+                int y2 = traceY(mathBuffer[nextIndex], center);
+                
+                display.drawLine(i, y1, i + 1, y2, SSD1306_WHITE);
+            }
+        }
+        
         // Show the current values and offset
         display.setCursor(0, 56);
         display.print(F("CH1:"));
-        display.print(value1);
-        if (scopeSettings.showChannel2) {
+        display.print(lastValue1);
+        if (showMath) {
+            display.print(F(" "));
+            display.print(mathLabel(mathMode));
+            display.print(F(":"));
+            display.print(mathSample(mathMode, lastValue1, lastValue2));
+        } else if (scopeSettings.showChannel2) {
             display.print(F(" CH2:"));
-            display.print(value2);
+            display.print(lastValue2);
             display.print(F(" Off:"));
             display.print(scopeSettings.channel2Offset);
+        } else {
+            display.print(F(" "));
+            display.print(scopeSettings.timeScale);
+            display.print(F("ms "));
+            display.print(scopeSettings.voltageScale);
+            display.print(F("/d"));
         }
         
-        // Add back to menu message
+        // Button hints
         display.setCursor(0, 0);
-        display.print(F("Press any button"));
+        display.print(F("BTN1:Auto BTN2:Math"));
         display.setCursor(0, 8);
-        display.print(F("to return to menu"));
+        display.print(F("BTN3-4: menu"));
         
         display.display();
-        lastSampleTime = millis();
+        lastFrameTime = millis();
     }
 }
 
 void updateSettings() {
+    if (!displayAttached) {
+        return;
+    }
+    
     display.clearDisplay();
     display.setCursor(0, 0);
     display.println(F("Scope Settings"));
@@ -622,7 +1039,11 @@ void updateSettings() {
     
     display.print(encoderValue == 2 ? F(">") : F(" "));
     display.print(F("Trig: "));
-    display.println(scopeSettings.triggerEnabled ? F("ON") : F("OFF"));
+    if (!scopeSettings.triggerEnabled) {
+        display.println(F("OFF"));
+    } else {
+        display.println(scopeSettings.triggerRising ? F("RISE") : F("FALL"));
+    }
     
     display.print(encoderValue == 3 ? F(">") : F(" "));
     display.print(F("Trig Lvl: "));
@@ -650,6 +1071,10 @@ void updateSettings() {
 }
 
 void updateButtonTest() {
+    if (!displayAttached) {
+        return;
+    }
+    
     display.clearDisplay();
     display.setCursor(0, 0);
     display.println(F("Button Test"));
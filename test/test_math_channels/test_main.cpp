@@ -0,0 +1,153 @@
+// Host checks and benchmark for the math channel kernels in include/math_channels.h
+// Run with: pio test -e native -v
+
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include "math_channels.h"
+
+#define BLOCK_SIZE 256         // Same as BUFFER_SIZE in src/main.cpp
+#define CHECK_ITERATIONS 2000  // Random blocks checked against the scalar reference
+#define BENCH_ITERATIONS 100000
+
+alignas(4) int16_t ch1[BLOCK_SIZE];
+alignas(4) int16_t ch2[BLOCK_SIZE];
+alignas(4) int16_t packed[BLOCK_SIZE];
+alignas(4) int16_t scalar[BLOCK_SIZE];
+
+void setUp() {}
+void tearDown() {}
+
+// Scalar reference: widen, compute, saturate to int16
+int16_t referenceSample(MathMode mode, int16_t a, int16_t b) {
+    long value;
+    switch (mode) {
+        case MATH_SUM:
+            value = (long)a + b;
+            break;
+        case MATH_DIFF:
+            value = (long)a - b;
+            break;
+        case MATH_PRODUCT:
+            value = ((long)a * b) >> MATH_PRODUCT_SHIFT;
+            break;
+        default:
+            return 0;
+    }
+    if (value > INT16_MAX) {
+        return INT16_MAX;
+    }
+    if (value < INT16_MIN) {
+        return INT16_MIN;
+    }
+    return (int16_t)value;
+}
+
+__attribute__((noinline)) void referenceBlock(MathMode mode, const int16_t *a, const int16_t *b,
+                                              int16_t *out, int count) {
+    for (int i = 0; i < count; i++) {
+        out[i] = referenceSample(mode, a[i], b[i]);
+    }
+}
+
+// Full-range random samples with the int16 limits mixed in so saturation is hit
+void fillFullRange() {
+    for (int i = 0; i < BLOCK_SIZE; i++) {
+        ch1[i] = (int16_t)rand();
+        ch2[i] = (int16_t)rand();
+        if (i % 7 == 0) {
+            ch1[i] = INT16_MAX;
+        }
+        if (i % 11 == 0) {
+            ch2[i] = INT16_MIN;
+        }
+        if (i % 13 == 0) {
+            ch1[i] = INT16_MIN;
+        }
+    }
+}
+
+// 10-bit samples, as the ADC produces them
+void fillAdcRange() {
+    for (int i = 0; i < BLOCK_SIZE; i++) {
+        ch1[i] = rand() % 1024;
+        ch2[i] = rand() % 1024;
+    }
+}
+
+void checkMode(MathMode mode) {
+    srand(1);
+    for (int iteration = 0; iteration < CHECK_ITERATIONS; iteration++) {
+        if (iteration % 2 == 0) {
+            fillFullRange();
+        } else {
+            fillAdcRange();
+        }
+        computeMathChannel(mode, ch1, ch2, packed, BLOCK_SIZE);
+        referenceBlock(mode, ch1, ch2, scalar, BLOCK_SIZE);
+        TEST_ASSERT_EQUAL_INT16_ARRAY(scalar, packed, BLOCK_SIZE);
+        for (int i = 0; i < BLOCK_SIZE; i++) {
+            TEST_ASSERT_EQUAL_INT(scalar[i], mathSample(mode, ch1[i], ch2[i]));
+        }
+    }
+}
+
+void test_sum_matches_reference() {
+    checkMode(MATH_SUM);
+}
+
+void test_diff_matches_reference() {
+    checkMode(MATH_DIFF);
+}
+
+void test_product_matches_reference() {
+    checkMode(MATH_PRODUCT);
+}
+
+void test_saturation_limits() {
+    TEST_ASSERT_EQUAL_HEX32(0x7FFF8000u, addSat16x2(0x7FFF8000u, 0x0001FFFFu));
+    TEST_ASSERT_EQUAL_HEX32(0x7FFF8000u, subSat16x2(0x7FFF8000u, 0xFFFF0001u));
+    TEST_ASSERT_EQUAL_HEX32(0x00000000u, subSat16x2(0x80007FFFu, 0x80007FFFu));
+}
+
+// Time the packed kernels against the scalar reference on one capture-sized block
+void benchmarkMode(MathMode mode, const char *name) {
+    volatile int16_t sink = 0;
+    fillAdcRange();
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < BENCH_ITERATIONS; i++) {
+        computeMathChannel(mode, ch1, ch2, packed, BLOCK_SIZE);
+        sink += packed[i % BLOCK_SIZE];
+    }
+    auto middle = std::chrono::steady_clock::now();
+    for (int i = 0; i < BENCH_ITERATIONS; i++) {
+        referenceBlock(mode, ch1, ch2, scalar, BLOCK_SIZE);
+        sink += scalar[i % BLOCK_SIZE];
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    double packedNs = std::chrono::duration<double, std::nano>(middle - start).count() / BENCH_ITERATIONS;
+    double scalarNs = std::chrono::duration<double, std::nano>(end - middle).count() / BENCH_ITERATIONS;
+    char message[128];
+    snprintf(message, sizeof(message), "%-7s packed %7.1f ns/frame, scalar %7.1f ns/frame (%d samples)",
+             name, packedNs, scalarNs, BLOCK_SIZE);
+    TEST_MESSAGE(message);
+}
+
+void test_benchmark() {
+    benchmarkMode(MATH_SUM, "A+B");
+    benchmarkMode(MATH_DIFF, "A-B");
+    benchmarkMode(MATH_PRODUCT, "AxB");
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_sum_matches_reference);
+    RUN_TEST(test_diff_matches_reference);
+    RUN_TEST(test_product_matches_reference);
+    RUN_TEST(test_saturation_limits);
+    RUN_TEST(test_benchmark);
+    return UNITY_END();
+}